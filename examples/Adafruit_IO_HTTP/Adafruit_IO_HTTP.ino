@@ -81,10 +81,9 @@ void transmitData(int value)
     return;
   }
 
-  // Set POST data
-  String combinedString = "value=";
-  combinedString += value;
-  if (!wifi.setHTTPPOSTParameters(handle, combinedString)) {
+  // Set POST data, which is written straight to the Wi-Fi chip as "value=123"
+  PayloadWriter(wifi.beginHTTPPOSTParameters(handle)).field(F("value"), value);
+  if (!wifi.endHTTPPOSTParameters()) {
     Serial.println(F("HTTP unable to set POST parameters! Skipping this connection attempt"));
     return;
   }
@@ -0,0 +1,112 @@
+/*
+  Adafruit IO with MQTT, batching fast sensor readings
+
+  For the SSTuino boards.
+
+  This example sketch reads a sensor 20 times a second, which is far faster
+  than Adafruit IO accepts messages. The readings are collected into windows
+  of 200 samples, and the mean of each window is published once every 10
+  seconds. Adafruit IO feeds only chart plain numbers, so TELEMETRY_MEAN is
+  used here. With other MQTT brokers, TELEMETRY_SUMMARY sends
+  "count=..&min=..&max=..&mean=..&last=.." instead.
+
+  This example code is in the public domain.
+
+  https://d3lta-v.github.io/SSTuino/
+*/
+
+#include "SSTuino_Companion.h"
+
+#define SSID         "SSID_GOES_HERE"
+#define PASSWORD     "WIFI_PASSWORD_GOES_HERE"
+#define IO_USERNAME  "AIO_USERNAME_GOES_HERE"
+#define IO_KEY       "AIO_KEY_GOES_HERE"
+#define FEED_KEY     "FEED_KEY_GOES_HERE"
+
+SSTuino wifi = SSTuino();
+
+// All memory for the batches is reserved here, so it cannot run out later
+// No arena is needed, as only feeds in TELEMETRY_RAW mode keep their samples
+TelemetryFeed feeds[1];
+Telemetry telemetry(wifi, feeds, 1, NULL, 0);
+int8_t sensorFeed;
+
+unsigned long previousSample = 0;
+
+void setup()
+{
+  Serial.begin(9600);
+
+  // Open the link between the two devices
+  wifi.openLink();
+
+  // Reset the Wi-Fi chip to clear any previous settings
+  wifi.reset();
+
+  // Verify that the link is ok between the two devices
+  if (!wifi.smokeTest()) {
+    Serial.println(F("Unable to establish link with Wi-Fi chip. Halting."));
+    while (true){};
+  }
+
+  wifiConnect();
+
+  setupMQTT();
+
+  // Publish the mean every 200 samples, or every 10 seconds, whichever comes first
+  sensorFeed = telemetry.addMQTTFeed(F(IO_USERNAME "/feeds/" FEED_KEY), TELEMETRY_MEAN, 200, 10000);
+  if (sensorFeed == -1) {
+    Serial.println(F("Unable to add telemetry feed. Halting."));
+    while (true){};
+  }
+}
+
+void loop()
+{
+  // Sample the sensor every 50 milliseconds
+  unsigned long currentMillis = millis();
+  if (currentMillis - previousSample >= 50) {
+    previousSample = currentMillis;
+    telemetry.add(sensorFeed, analogRead(A0));
+  }
+
+  // Sends any window whose 10 seconds are up
+  telemetry.poll();
+}
+
+void wifiConnect(void)
+{
+  // Connects to Wifi and displays connection state
+  wifi.connectToWifi(F(SSID), F(PASSWORD));
+  Serial.println(F("Connecting to Wi-Fi..."));
+
+  delay(10000); // 10 seconds optimal for wifi connection to fully establish
+
+  Status wifiStatus = wifi.getWifiStatus();
+  if (wifiStatus != SUCCESSFUL) {
+    Serial.println(F("Failed to connect to Wi-Fi"));
+    while (true){};
+  } else {
+    Serial.println(F("Wi-Fi connected"));
+  }
+}
+
+void setupMQTT(void)
+{
+  // Setup MQTT
+  Serial.println(F("Setting up MQTT..."));
+  bool mqttSuccess = wifi.enableMQTT(F("io.adafruit.com"), true, IO_USERNAME, IO_KEY);
+  if (!mqttSuccess) {
+    Serial.println(F("Failed to enable MQTT. Halting."));
+    while (true){};
+  }
+  delay(10000); // Wait for MQTT to fully connect
+
+  // Check if MQTT is connected
+  if (!wifi.isMQTTConnected()) {
+    Serial.println(F("MQTT did not connect successfully!"));
+    while (true){};
+  } else {
+    Serial.println(F("MQTT connected!"));
+  }
+}
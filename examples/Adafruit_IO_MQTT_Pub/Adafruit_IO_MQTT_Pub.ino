@@ -60,6 +60,11 @@ void loop()
     transmitData(String(yourVariableHere));
 
     where yourVariableHere is the name of your own variable
+
+    Numbers can also be published without converting them to a String first,
+    which is faster and uses less memory:
+
+    wifi.mqttPublish(F(IO_USERNAME "/feeds/" FEED_KEY), yourNumberHere);
   */
 
   transmitData(String("data"));
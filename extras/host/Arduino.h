@@ -0,0 +1,63 @@
+/******************************************************************************
+ *                                                                            *
+ * NAME: Arduino.h                                                            *
+ *                                                                            *
+ * PURPOSE: Minimal stand-in for the Arduino core so that the library can be  *
+ *          compiled and driven on a Linux host                               *
+ *                                                                            *
+ * GLOBAL VARIABLES:                                                          *
+ *                                                                            *
+ * Variable Type Description                                                  *
+ * -------- ---- -----------                                                  *
+ * hostMicros unsigned long long Virtual clock, in microseconds              *
+ * hostLink HostLink* The endpoint that plays the part of the ESP-01 module   *
+ *                                                                            *
+ *****************************************************************************/
+
+#ifndef __SSTuino_Host_Arduino__
+#define __SSTuino_Host_Arduino__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "WString.h"
+#include "Print.h"
+#include "Stream.h"
+
+/*
+ * Program memory is ordinary memory on the host
+ */
+
+#define PROGMEM
+#define strcpy_P(dest, src) strcpy((dest), (src))
+#define pgm_read_byte(addr) (*(const unsigned char *)(addr))
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+/*
+ * Virtual time and the module endpoint
+ */
+
+class HostLink {
+public:
+    virtual ~HostLink() {}
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+    virtual size_t write(uint8_t data) = 0;
+    // Called whenever the library polls the clock, so that time can pass
+    virtual void idle() {}
+};
+
+extern unsigned long long hostMicros;
+extern HostLink* hostLink;
+
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+#endif  // End of __SSTuino_Host_Arduino__ definition check
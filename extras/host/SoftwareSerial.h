@@ -0,0 +1,27 @@
+/******************************************************************************
+ *                                                                            *
+ * NAME: SoftwareSerial.h                                                     *
+ *                                                                            *
+ * PURPOSE: Host stand-in for SoftwareSerial that forwards to hostLink        *
+ *                                                                            *
+ *****************************************************************************/
+
+#ifndef __SSTuino_Host_SoftwareSerial__
+#define __SSTuino_Host_SoftwareSerial__
+
+#include "Arduino.h"
+
+class SoftwareSerial : public Stream {
+public:
+    SoftwareSerial(uint8_t receivePin, uint8_t transmitPin) { (void)receivePin; (void)transmitPin; }
+    void begin(long speed) { (void)speed; }
+
+    int available() { return hostLink ? hostLink->available() : 0; }
+    int read() { return hostLink ? hostLink->read() : -1; }
+    int peek() { return hostLink ? hostLink->peek() : -1; }
+    void flush() {}
+    size_t write(uint8_t data) { return hostLink ? hostLink->write(data) : 1; }
+    using Print::write;
+};
+
+#endif  // End of __SSTuino_Host_SoftwareSerial__ definition check
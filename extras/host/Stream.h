@@ -0,0 +1,21 @@
+/******************************************************************************
+ *                                                                            *
+ * NAME: Stream.h                                                             *
+ *                                                                            *
+ * PURPOSE: Host stand-in for the Arduino Stream class                        *
+ *                                                                            *
+ *****************************************************************************/
+
+#ifndef __SSTuino_Host_Stream__
+#define __SSTuino_Host_Stream__
+
+#include "Print.h"
+
+class Stream : public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+};
+
+#endif  // End of __SSTuino_Host_Stream__ definition check
@@ -0,0 +1,96 @@
+/******************************************************************************
+ *                                                                            *
+ * NAME: WString.h                                                            *
+ *                                                                            *
+ * PURPOSE: Host stand-in for the Arduino String class. Buffers are managed   *
+ *          the same way as the AVR core (no small string optimisation).      *
+ *                                                                            *
+ *****************************************************************************/
+
+#ifndef __SSTuino_Host_WString__
+#define __SSTuino_Host_WString__
+
+#include <stddef.h>
+
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper *>(string_literal))
+
+// Heap use by String buffers, so that host benchmarks can report allocations
+struct HostHeapStats {
+    unsigned long allocations;
+    unsigned long bytesInUse;
+    unsigned long peakBytes;
+};
+
+extern HostHeapStats hostHeap;
+
+class String {
+public:
+    String(const char* cstr = "");
+    String(const String& str);
+    String(const __FlashStringHelper* str);
+    explicit String(char c);
+    explicit String(unsigned char value, unsigned char base = 10);
+    explicit String(int value, unsigned char base = 10);
+    explicit String(unsigned int value, unsigned char base = 10);
+    explicit String(long value, unsigned char base = 10);
+    explicit String(unsigned long value, unsigned char base = 10);
+    explicit String(double value, unsigned char decimalPlaces = 2);
+    ~String();
+
+    unsigned char reserve(unsigned int size);
+    unsigned int length(void) const { return len; }
+
+    String& operator=(const String& rhs);
+    String& operator=(const char* cstr);
+    String& operator=(const __FlashStringHelper* str);
+
+    unsigned char concat(const String& str);
+    unsigned char concat(const char* cstr);
+    unsigned char concat(const char* cstr, unsigned int length);
+    unsigned char concat(char c);
+    unsigned char concat(int num);
+    unsigned char concat(unsigned int num);
+    unsigned char concat(long num);
+    unsigned char concat(unsigned long num);
+    unsigned char concat(double num);
+
+    String& operator+=(const String& rhs) { concat(rhs); return *this; }
+    String& operator+=(const char* cstr) { concat(cstr); return *this; }
+    String& operator+=(char c) { concat(c); return *this; }
+    String& operator+=(int num) { concat(num); return *this; }
+    String& operator+=(unsigned int num) { concat(num); return *this; }
+    String& operator+=(long num) { concat(num); return *this; }
+    String& operator+=(unsigned long num) { concat(num); return *this; }
+    String& operator+=(double num) { concat(num); return *this; }
+
+    unsigned char equals(const String& s) const;
+    unsigned char equals(const char* cstr) const;
+    unsigned char operator==(const String& rhs) const { return equals(rhs); }
+    unsigned char operator==(const char* cstr) const { return equals(cstr); }
+
+    char charAt(unsigned int index) const;
+    int indexOf(char ch) const;
+    int indexOf(const String& str) const;
+    long toInt(void) const;
+    const char* c_str() const { return buffer ? buffer : ""; }
+
+private:
+    char* buffer;
+    unsigned int capacity;
+    unsigned int len;
+
+    void init(void);
+    void invalidate(void);
+    void release(void);
+    unsigned char changeBuffer(unsigned int maxStrLen);
+    String& copy(const char* cstr, unsigned int length);
+};
+
+String operator+(const String& lhs, const String& rhs);
+String operator+(const String& lhs, const char* rhs);
+String operator+(const String& lhs, int rhs);
+String operator+(const String& lhs, long rhs);
+String operator+(const String& lhs, double rhs);
+
+#endif  // End of __SSTuino_Host_WString__ definition check
@@ -0,0 +1,454 @@
+/******************************************************************************
+ *                                                                            *
+ * FILE NAME: arduino_host.cpp                                                *
+ *                                                                            *
+ * PURPOSE: Implements the host stand-in for the Arduino core                 *
+ *                                                                            *
+ * ASSUMPTIONS, CONSTRAINTS, RESTRICTIONS: single threaded                    *
+ *                                                                            *
+ * NOTES: time only moves when delay() is called or when hostLink advances    *
+ * it, from idle() or by charging the CPU time spent between its callbacks    *
+ *                                                                            *
+ *****************************************************************************/
+
+#include "Arduino.h"
+
+#include <math.h>
+#include <stdio.h>
+
+/******************************************************************************
+ * Virtual time                                                               *
+ *****************************************************************************/
+
+unsigned long long hostMicros = 0;
+HostLink* hostLink = NULL;
+
+unsigned long millis(void) {
+    if (hostLink) hostLink->idle();
+    return (unsigned long)(hostMicros / 1000);
+}
+
+unsigned long micros(void) {
+    return (unsigned long)hostMicros;
+}
+
+void delay(unsigned long ms) {
+    hostMicros += (unsigned long long)ms * 1000;
+}
+
+void delayMicroseconds(unsigned int us) {
+    hostMicros += us;
+}
+
+/******************************************************************************
+ * String                                                                     *
+ *****************************************************************************/
+
+HostHeapStats hostHeap = { 0, 0, 0 };
+
+String::String(const char* cstr) {
+    init();
+    if (cstr) copy(cstr, strlen(cstr));
+}
+
+String::String(const String& value) {
+    init();
+    *this = value;
+}
+
+String::String(const __FlashStringHelper* str) {
+    init();
+    *this = str;
+}
+
+String::String(char c) {
+    init();
+    char buf[2] = { c, '\0' };
+    *this = buf;
+}
+
+String::String(unsigned char value, unsigned char base) {
+    init();
+    *this = String((unsigned long)value, base);
+}
+
+String::String(int value, unsigned char base) {
+    init();
+    *this = String((long)value, base);
+}
+
+String::String(unsigned int value, unsigned char base) {
+    init();
+    *this = String((unsigned long)value, base);
+}
+
+String::String(long value, unsigned char base) {
+    init();
+    char buf[2 + 8 * sizeof(long)];
+    if (base == 16) snprintf(buf, sizeof(buf), "%lx", value);
+    else if (base == 8) snprintf(buf, sizeof(buf), "%lo", value);
+    else snprintf(buf, sizeof(buf), "%ld", value);
+    *this = buf;
+}
+
+String::String(unsigned long value, unsigned char base) {
+    init();
+    char buf[1 + 8 * sizeof(unsigned long)];
+    if (base == 16) snprintf(buf, sizeof(buf), "%lx", value);
+    else if (base == 8) snprintf(buf, sizeof(buf), "%lo", value);
+    else snprintf(buf, sizeof(buf), "%lu", value);
+    *this = buf;
+}
+
+String::String(double value, unsigned char decimalPlaces) {
+    init();
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%4.*f", decimalPlaces, value);
+    *this = buf;
+}
+
+String::~String() {
+    release();
+}
+
+void String::init(void) {
+    buffer = NULL;
+    capacity = 0;
+    len = 0;
+}
+
+void String::release(void) {
+    if (buffer) hostHeap.bytesInUse -= capacity + 1;
+    free(buffer);
+}
+
+void String::invalidate(void) {
+    release();
+    buffer = NULL;
+    capacity = len = 0;
+}
+
+unsigned char String::reserve(unsigned int size) {
+    if (buffer && capacity >= size) return 1;
+    if (changeBuffer(size)) {
+        if (len == 0) buffer[0] = 0;
+        return 1;
+    }
+    return 0;
+}
+
+unsigned char String::changeBuffer(unsigned int maxStrLen) {
+    char* newbuffer = (char *)realloc(buffer, maxStrLen + 1);
+    if (newbuffer) {
+        if (buffer) hostHeap.bytesInUse -= capacity + 1;
+        hostHeap.bytesInUse += maxStrLen + 1;
+        if (hostHeap.bytesInUse > hostHeap.peakBytes) hostHeap.peakBytes = hostHeap.bytesInUse;
+        hostHeap.allocations++;
+        buffer = newbuffer;
+        capacity = maxStrLen;
+        return 1;
+    }
+    return 0;
+}
+
+String& String::copy(const char* cstr, unsigned int length) {
+    if (!reserve(length)) {
+        invalidate();
+        return *this;
+    }
+    len = length;
+    memmove(buffer, cstr, length);
+    buffer[len] = 0;
+    return *this;
+}
+
+String& String::operator=(const String& rhs) {
+    if (this == &rhs) return *this;
+    if (rhs.buffer) copy(rhs.buffer, rhs.len);
+    else invalidate();
+    return *this;
+}
+
+String& String::operator=(const char* cstr) {
+    if (cstr) copy(cstr, strlen(cstr));
+    else invalidate();
+    return *this;
+}
+
+String& String::operator=(const __FlashStringHelper* str) {
+    const char* cstr = reinterpret_cast<const char *>(str);
+    if (cstr) copy(cstr, strlen(cstr));
+    else invalidate();
+    return *this;
+}
+
+unsigned char String::concat(const char* cstr, unsigned int length) {
+    unsigned int newlen = len + length;
+    if (!cstr) return 0;
+    if (length == 0) return 1;
+    if (!reserve(newlen)) return 0;
+    memmove(buffer + len, cstr, length);
+    len = newlen;
+    buffer[len] = 0;
+    return 1;
+}
+
+unsigned char String::concat(const String& s) {
+    return concat(s.c_str(), s.len);
+}
+
+unsigned char String::concat(const char* cstr) {
+    if (!cstr) return 0;
+    return concat(cstr, strlen(cstr));
+}
+
+unsigned char String::concat(char c) {
+    char buf[2] = { c, '\0' };
+    return concat(buf, 1);
+}
+
+unsigned char String::concat(int num) {
+    char buf[2 + 3 * sizeof(int)];
+    snprintf(buf, sizeof(buf), "%d", num);
+    return concat(buf, strlen(buf));
+}
+
+unsigned char String::concat(unsigned int num) {
+    char buf[1 + 3 * sizeof(unsigned int)];
+    snprintf(buf, sizeof(buf), "%u", num);
+    return concat(buf, strlen(buf));
+}
+
+unsigned char String::concat(long num) {
+    char buf[2 + 3 * sizeof(long)];
+    snprintf(buf, sizeof(buf), "%ld", num);
+    return concat(buf, strlen(buf));
+}
+
+unsigned char String::concat(unsigned long num) {
+    char buf[1 + 3 * sizeof(unsigned long)];
+    snprintf(buf, sizeof(buf), "%lu", num);
+    return concat(buf, strlen(buf));
+}
+
+unsigned char String::concat(double num) {
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%4.2f", num);
+    return concat(buf, strlen(buf));
+}
+
+unsigned char String::equals(const String& s2) const {
+    return (len == s2.len && strcmp(c_str(), s2.c_str()) == 0);
+}
+
+unsigned char String::equals(const char* cstr) const {
+    if (len == 0) return (cstr == NULL || *cstr == 0);
+    if (cstr == NULL) return buffer[0] == 0;
+    return strcmp(buffer, cstr) == 0;
+}
+
+char String::charAt(unsigned int index) const {
+    if (index >= len || !buffer) return 0;
+    return buffer[index];
+}
+
+int String::indexOf(char ch) const {
+    if (!buffer) return -1;
+    const char* found = strchr(buffer, ch);
+    if (found == NULL) return -1;
+    return found - buffer;
+}
+
+int String::indexOf(const String& str) const {
+    if (!buffer) return -1;
+    const char* found = strstr(buffer, str.c_str());
+    if (found == NULL) return -1;
+    return found - buffer;
+}
+
+long String::toInt(void) const {
+    if (buffer) return atol(buffer);
+    return 0;
+}
+
+String operator+(const String& lhs, const String& rhs) {
+    String result(lhs);
+    result.concat(rhs);
+    return result;
+}
+
+String operator+(const String& lhs, const char* rhs) {
+    String result(lhs);
+    result.concat(rhs);
+    return result;
+}
+
+String operator+(const String& lhs, int rhs) {
+    String result(lhs);
+    result.concat(rhs);
+    return result;
+}
+
+String operator+(const String& lhs, long rhs) {
+    String result(lhs);
+    result.concat(rhs);
+    return result;
+}
+
+String operator+(const String& lhs, double rhs) {
+    String result(lhs);
+    result.concat(rhs);
+    return result;
+}
+
+/******************************************************************************
+ * Print                                                                      *
+ *****************************************************************************/
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+    size_t n = 0;
+    while (size--) {
+        if (write(*buffer++)) n++;
+        else break;
+    }
+    return n;
+}
+
+size_t Print::print(const __FlashStringHelper* str) {
+    return write(reinterpret_cast<const char *>(str));
+}
+
+size_t Print::print(const String& str) {
+    return write(str.c_str(), str.length());
+}
+
+size_t Print::print(const char str[]) {
+    return write(str);
+}
+
+size_t Print::print(char c) {
+    return write((uint8_t)c);
+}
+
+size_t Print::print(unsigned char n, int base) {
+    return print((unsigned long)n, base);
+}
+
+size_t Print::print(int n, int base) {
+    return print((long)n, base);
+}
+
+size_t Print::print(unsigned int n, int base) {
+    return print((unsigned long)n, base);
+}
+
+size_t Print::print(long n, int base) {
+    if (base == 0) {
+        return write((uint8_t)n);
+    } else if (base == 10 && n < 0) {
+        size_t t = print('-');
+        return printNumber(-(unsigned long)n, 10) + t;
+    }
+    return printNumber(n, base);
+}
+
+size_t Print::print(unsigned long n, int base) {
+    if (base == 0) return write((uint8_t)n);
+    return printNumber(n, base);
+}
+
+size_t Print::print(double n, int digits) {
+    return printFloat(n, digits);
+}
+
+size_t Print::println(void) {
+    return write("\r\n");
+}
+
+size_t Print::println(const __FlashStringHelper* str) {
+    size_t n = print(str);
+    return n + println();
+}
+
+size_t Print::println(const String& str) {
+    size_t n = print(str);
+    return n + println();
+}
+
+size_t Print::println(const char str[]) {
+    size_t n = print(str);
+    return n + println();
+}
+
+size_t Print::println(char c) {
+    size_t n = print(c);
+    return n + println();
+}
+
+size_t Print::println(int num, int base) {
+    size_t n = print(num, base);
+    return n + println();
+}
+
+size_t Print::println(unsigned int num, int base) {
+    size_t n = print(num, base);
+    return n + println();
+}
+
+size_t Print::println(long num, int base) {
+    size_t n = print(num, base);
+    return n + println();
+}
+
+size_t Print::println(unsigned long num, int base) {
+    size_t n = print(num, base);
+    return n + println();
+}
+
+size_t Print::println(double num, int digits) {
+    size_t n = print(num, digits);
+    return n + println();
+}
+
+size_t Print::printNumber(unsigned long n, uint8_t base) {
+    char buf[8 * sizeof(long) + 1];
+    char* str = &buf[sizeof(buf) - 1];
+    *str = '\0';
+    if (base < 2) base = 10;
+    do {
+        char c = n % base;
+        n /= base;
+        *--str = c < 10 ? c + '0' : c + 'A' - 10;
+    } while (n);
+    return write(str);
+}
+
+size_t Print::printFloat(double number, uint8_t digits) {
+    size_t n = 0;
+    if (isnan(number)) return print("nan");
+    if (isinf(number)) return print("inf");
+    if (number > 4294967040.0) return print("ovf");
+    if (number < -4294967040.0) return print("ovf");
+
+    if (number < 0.0) {
+        n += print('-');
+        number = -number;
+    }
+
+    double rounding = 0.5;
+    for (uint8_t i = 0; i < digits; ++i) rounding /= 10.0;
+    number += rounding;
+
+    unsigned long int_part = (unsigned long)number;
+    double remainder = number - (double)int_part;
+    n += print(int_part);
+
+    if (digits > 0) n += print('.');
+    while (digits-- > 0) {
+        remainder *= 10.0;
+        unsigned int toPrint = (unsigned int)remainder;
+        n += print(toPrint);
+        remainder -= toPrint;
+    }
+    return n;
+}
@@ -0,0 +1,233 @@
+/******************************************************************************
+ *                                                                            *
+ * FILE NAME: bench.cpp                                                       *
+ *                                                                            *
+ * PURPOSE: Measures the per-sample cost of publishing telemetry, comparing   *
+ *          the String-based calls with the typed, allocation-free ones and   *
+ *          with batching through the telemetry aggregator                    *
+ *                                                                            *
+ * USAGE: sstuino-bench [samples]                                             *
+ *                                                                            *
+ * ABNORMAL TERMINATION CONDITIONS, ERROR AND WARNING MESSAGES: exits with 1  *
+ * if two paths that should send the same bytes to the module do not          *
+ *                                                                            *
+ * NOTES: the module is simulated by a link that acknowledges every command   *
+ * line at once, so the timings are CPU time spent inside the library only.  *
+ * Heap figures count String buffers, which is all the library allocates.     *
+ *                                                                            *
+ *****************************************************************************/
+
+#include "SSTuino_Companion.h"
+
+#include <chrono>
+#include <stdio.h>
+
+#define TOPIC "username/feeds/sensor"
+
+/******************************************************************************
+ * Simulated module                                                           *
+ *****************************************************************************/
+
+class BenchLink : public HostLink {
+public:
+    BenchLink() : reply(""), lineLength(0), setupCommand(false), previous(0), bytesSent(0), messages(0),
+                  checksum(2166136261u) {}
+
+    int available() { return strlen(reply); }
+    int read() {
+        if (*reply == '\0') return -1;
+        return *reply++;
+    }
+    int peek() { return *reply ? *reply : -1; }
+    size_t write(uint8_t data) {
+        bytesSent++;
+        checksum = (checksum ^ data) * 16777619u;   // FNV-1a over everything sent
+        if (lineLength == 0) setupCommand = data == 'i';
+        lineLength++;
+        // Only \r\n ends a command, a \n alone may be part of HTTP headers
+        if (previous == '\r' && data == '\n') {
+            // HTTP setup replies with a handle, everything else with success
+            reply = setupCommand ? "0\r\n" : "S";
+            lineLength = 0;
+            messages++;
+        }
+        previous = data;
+        return 1;
+    }
+
+    void reset() {
+        reply = "";
+        lineLength = 0;
+        previous = 0;
+        bytesSent = 0;
+        messages = 0;
+        checksum = 2166136261u;
+    }
+
+    const char* reply;
+    unsigned int lineLength;
+    bool setupCommand;
+    uint8_t previous;
+    unsigned long bytesSent;
+    unsigned long messages;                         // Command lines sent to the module
+    uint32_t checksum;
+};
+
+struct BenchResult {
+    const char* name;
+    double nanosPerSample;
+    double allocationsPerSample;
+    unsigned long peakHeapBytes;
+    unsigned long bytesSent;
+    unsigned long messages;
+    uint32_t checksum;
+};
+
+/******************************************************************************
+ * Publish paths                                                              *
+ *****************************************************************************/
+
+static long sampleValue(unsigned long i) {
+    return (long)(i * 37 % 100000) - 5000;
+}
+
+static void mqttString(SSTuino& wifi, unsigned long i) {
+    wifi.mqttPublish(F(TOPIC), String(sampleValue(i)));
+}
+
+static void mqttTyped(SSTuino& wifi, unsigned long i) {
+    wifi.mqttPublish(F(TOPIC), sampleValue(i));
+}
+
+static void mqttFloatString(SSTuino& wifi, unsigned long i) {
+    wifi.mqttPublish(F(TOPIC), String(sampleValue(i) / 100.0, 2));
+}
+
+static void mqttFloatTyped(SSTuino& wifi, unsigned long i) {
+    wifi.mqttPublish(F(TOPIC), sampleValue(i) / 100.0, 2);
+}
+
+static void mqttFixed(SSTuino& wifi, unsigned long i) {
+    wifi.mqttPublishFixed(F(TOPIC), sampleValue(i), 2);
+}
+
+static void httpString(SSTuino& wifi, unsigned long i) {
+    String combinedString = "value=";
+    combinedString += sampleValue(i);
+    wifi.setHTTPPOSTParameters(0, combinedString);
+}
+
+static void httpWriter(SSTuino& wifi, unsigned long i) {
+    PayloadWriter(wifi.beginHTTPPOSTParameters(0)).field(F("value"), sampleValue(i));
+    wifi.endHTTPPOSTParameters();
+}
+
+// Telemetry aggregator with summary, raw and HTTP feeds of 32 samples per window
+static TelemetryFeed telemetryFeeds[3];
+static float telemetryArena[32];
+static Telemetry* telemetry;
+static int8_t summaryFeed;
+static int8_t rawFeed;
+static int8_t httpFeed;
+
+static void telemetrySummary(SSTuino& wifi, unsigned long i) {
+    (void)wifi;
+    telemetry->add(summaryFeed, sampleValue(i) / 100.0);
+}
+
+static void telemetryRaw(SSTuino& wifi, unsigned long i) {
+    (void)wifi;
+    telemetry->add(rawFeed, sampleValue(i) / 100.0);
+}
+
+static void telemetryHTTP(SSTuino& wifi, unsigned long i) {
+    (void)wifi;
+    telemetry->add(httpFeed, sampleValue(i) / 100.0);
+}
+
+static BenchResult run(const char* name, void (*publish)(SSTuino&, unsigned long), SSTuino& wifi,
+                       BenchLink& link, unsigned long samples) {
+    link.reset();
+    hostHeap.allocations = 0;
+    hostHeap.peakBytes = hostHeap.bytesInUse;
+    unsigned long baseline = hostHeap.bytesInUse;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (unsigned long i = 0; i < samples; i++) publish(wifi, i);
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+    BenchResult result;
+    result.name = name;
+    result.nanosPerSample = std::chrono::duration<double, std::nano>(end - start).count() / samples;
+    result.allocationsPerSample = (double)hostHeap.allocations / samples;
+    result.peakHeapBytes = hostHeap.peakBytes - baseline;
+    result.bytesSent = link.bytesSent;
+    result.messages = link.messages;
+    result.checksum = link.checksum;
+    return result;
+}
+
+static void print(const BenchResult& result) {
+    printf("%-28s %10.1f %12.2f %10lu %12lu %10lu\n", result.name, result.nanosPerSample,
+           result.allocationsPerSample, result.peakHeapBytes, result.bytesSent, result.messages);
+}
+
+static bool sameOutput(const BenchResult& a, const BenchResult& b) {
+    if (a.checksum == b.checksum && a.bytesSent == b.bytesSent) return true;
+    fprintf(stderr, "%s and %s sent different bytes to the module\n", a.name, b.name);
+    return false;
+}
+
+/******************************************************************************
+ * Main                                                                       *
+ *****************************************************************************/
+
+int main(int argc, char** argv) {
+    unsigned long samples = argc > 1 ? strtoul(argv[1], NULL, 10) : 200000;
+    if (samples == 0) samples = 1;
+
+    BenchLink link;
+    hostLink = &link;
+    SSTuino wifi;
+    wifi.openLink();
+
+    printf("%lu samples per path\n\n", samples);
+    printf("%-28s %10s %12s %10s %12s %10s\n", "path", "ns/sample", "allocs/sample", "peak heap", "bytes sent",
+           "messages");
+
+    BenchResult mqttStringResult = run("mqttPublish(String)", mqttString, wifi, link, samples);
+    BenchResult mqttTypedResult = run("mqttPublish(long)", mqttTyped, wifi, link, samples);
+    BenchResult mqttFloatStringResult = run("mqttPublish(String(float))", mqttFloatString, wifi, link, samples);
+    BenchResult mqttFloatTypedResult = run("mqttPublish(double)", mqttFloatTyped, wifi, link, samples);
+    BenchResult mqttFixedResult = run("mqttPublishFixed", mqttFixed, wifi, link, samples);
+    BenchResult httpStringResult = run("setHTTPPOSTParameters", httpString, wifi, link, samples);
+    BenchResult httpWriterResult = run("PayloadWriter (HTTP POST)", httpWriter, wifi, link, samples);
+
+    Telemetry aggregator(wifi, telemetryFeeds, 3, telemetryArena, 32);
+    telemetry = &aggregator;
+    summaryFeed = aggregator.addMQTTFeed(F(TOPIC), TELEMETRY_SUMMARY, 32);
+    rawFeed = aggregator.addMQTTFeed(F(TOPIC), TELEMETRY_RAW, 32);
+    httpFeed = aggregator.addHTTPFeed(F("https://example.com/data"), F("X-Key: key\n"), TELEMETRY_SUMMARY, 32);
+    BenchResult summaryResult = run("Telemetry (summary of 32)", telemetrySummary, wifi, link, samples);
+    BenchResult rawResult = run("Telemetry (raw, 32)", telemetryRaw, wifi, link, samples);
+    BenchResult httpResult = run("Telemetry (HTTP, 32)", telemetryHTTP, wifi, link, samples);
+
+    print(mqttStringResult);
+    print(mqttTypedResult);
+    print(mqttFloatStringResult);
+    print(mqttFloatTypedResult);
+    print(mqttFixedResult);
+    print(httpStringResult);
+    print(httpWriterResult);
+    print(summaryResult);
+    print(rawResult);
+    print(httpResult);
+
+    hostLink = NULL;
+
+    bool consistent = sameOutput(mqttStringResult, mqttTypedResult);
+    consistent = sameOutput(mqttFloatStringResult, mqttFloatTypedResult) && consistent;
+    consistent = sameOutput(mqttFloatTypedResult, mqttFixedResult) && consistent;
+    consistent = sameOutput(httpStringResult, httpWriterResult) && consistent;
+    return consistent ? 0 : 1;
+}
@@ -0,0 +1,609 @@
+/******************************************************************************
+ *                                                                            *
+ * FILE NAME: replay.cpp                                                      *
+ *                                                                            *
+ * PURPOSE: Replays a UART trace recorded with SSTuino::beginTrace through    *
+ *          the library's own parsing code and reports where the time went    *
+ *                                                                            *
+ * USAGE: sstuino-replay [--csv] [--cpu-scale n] [--max-receive-ms ms]        *
+ *                       [--slow-read-us us] trace.bin                        *
+ *                                                                            *
+ *        --cpu-scale multiplies the measured host CPU time, as the AVR is    *
+ *        much slower than the host (default 1).                              *
+ *        --max-receive-ms fails the replay if more time than this is spent   *
+ *        receiving and scanning replies. --slow-read-us spends this much     *
+ *        CPU time before every byte the library reads, to check that a       *
+ *        slower parser shows up in the report.                               *
+ *                                                                            *
+ * ABNORMAL TERMINATION CONDITIONS, ERROR AND WARNING MESSAGES: exits with 1  *
+ * if the trace cannot be read, with 2 if the library sent different bytes    *
+ * from the ones in the trace (the replay diverged), and with 3 if receiving  *
+ * took longer than --max-receive-ms                                          *
+ *                                                                            *
+ * ASSUMPTIONS, CONSTRAINTS, RESTRICTIONS: a command line sent to the module  *
+ * is mapped back to the public function that sends it. "lap" is always       *
+ * replayed as getWifiHotspots, as wifiInRange sends the same bytes.          *
+ *                                                                            *
+ * NOTES: each command starts at its recorded time, or later if the library   *
+ * is still busy with the previous one. The command's TX and RX bytes are     *
+ * shifted by the same amount, so a slower library delays the replies to its  *
+ * own commands instead of finding them already waiting. Time spent polling   *
+ * inside the library is advanced in steps of at most 1 ms, and the host CPU  *
+ * time the library spends between calls into the link (scanning, copying,    *
+ * String growth) is measured and added to the virtual clock, so a slower     *
+ * parser delays every byte after it. That CPU time is the host's, not the    *
+ * AVR's, and includes the few microseconds taken to decode the arguments.    *
+ *                                                                            *
+ *****************************************************************************/
+
+#include "SSTuino_Companion.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+/*
+ * Trace records and commands
+ */
+
+struct Record {
+    unsigned long long time;        // Absolute time since the trace started, in microseconds
+    bool tx;
+    uint8_t data;
+    long command;                   // Index of the last command sent before this record, -1 if none
+};
+
+struct Command {
+    std::vector<size_t> txRecords;  // Indices into the record list
+    std::string text;               // The command line without the trailing newline
+};
+
+struct CallProfile {
+    std::string name;
+    std::string result;
+    unsigned long long start;       // First TX byte
+    unsigned long long txEnd;       // Last TX byte
+    unsigned long long firstRx;     // First RX byte read after the command was sent
+    unsigned long long end;         // Return from the library
+    unsigned long rxBytes;
+    unsigned long flushedBytes;     // Stale bytes drained by rx_empty before sending
+    unsigned long unframedBytes;    // Bytes outside the XON/XOFF frame of a flow-controlled reply
+    bool diverged;
+};
+
+/******************************************************************************
+ * Replay endpoint                                                            *
+ *****************************************************************************/
+
+class ReplayLink : public HostLink {
+public:
+    ReplayLink(const std::vector<Record>& records, size_t commandCount, double cpuScale, unsigned long readCost)
+        : records(records), offsets(commandCount, 0), current(-1), rxCursor(0), profile(NULL),
+          cpuNanos(0), cpuScale(cpuScale), readCost(readCost) {
+        skipTX();
+    }
+
+    void beginCall(long index, const Command& command, CallProfile* callProfile, bool flowControlled) {
+        current = index;
+        offsets[index] = hostMicros - records[command.txRecords.front()].time;
+        expectedTX = &command.txRecords;
+        txCursor = 0;
+        profile = callProfile;
+        framed = false;
+        this->flowControlled = flowControlled;
+        leave();
+    }
+
+    void endCall() {
+        charge();
+        if (txCursor != expectedTX->size()) profile->diverged = true;
+        profile = NULL;
+    }
+
+    unsigned long pendingRX() {
+        unsigned long count = 0;
+        for (size_t i = rxCursor; i < records.size(); i++) {
+            if (!records[i].tx) count++;
+        }
+        return count;
+    }
+
+    int available() {
+        LibraryTime libraryTime(*this);
+        return due() ? 1 : 0;
+    }
+
+    int read() {
+        if (profile) spend(readCost);
+        LibraryTime libraryTime(*this);
+        if (!due()) return -1;
+        uint8_t c = records[rxCursor].data;
+        rxCursor++;
+        skipTX();
+        if (profile) account(c);
+        return c;
+    }
+
+    int peek() {
+        LibraryTime libraryTime(*this);
+        return due() ? records[rxCursor].data : -1;
+    }
+
+    size_t write(uint8_t data) {
+        if (!profile) return 1;
+        LibraryTime libraryTime(*this);
+        if (txCursor >= expectedTX->size()) {
+            profile->diverged = true;
+            return 1;
+        }
+        const Record& expected = records[(*expectedTX)[txCursor]];
+        if (expected.data != data) profile->diverged = true;
+        unsigned long long sent = expected.time + offsets[current];
+        if (sent > hostMicros) hostMicros = sent;
+        if (txCursor == 0) profile->start = hostMicros;
+        profile->txEnd = hostMicros;
+        txCursor++;
+        return 1;
+    }
+
+    void idle() {
+        LibraryTime libraryTime(*this);
+        unsigned long long next = rxCursor < records.size() ? dueTime(records[rxCursor]) : NEVER;
+        if (next == NEVER) {
+            hostMicros += 1000;
+        } else if (next > hostMicros) {
+            unsigned long long step = next - hostMicros;
+            hostMicros += step < 1000 ? step : 1000;
+        }
+    }
+
+private:
+    const std::vector<Record>& records;
+    std::vector<unsigned long long> offsets;    // How much later than recorded each command was replayed
+    long current;                   // Command being replayed
+    size_t rxCursor;                // Next RX record to be read
+    const std::vector<size_t>* expectedTX;
+    size_t txCursor;
+    CallProfile* profile;
+    bool framed;
+    bool flowControlled;
+    std::chrono::steady_clock::time_point lastLeft;  // When the library last got control back
+    double cpuNanos;                // Measured time not yet added to the clock
+    double cpuScale;                // Target CPU time per unit of host CPU time
+    unsigned long readCost;         // CPU time to spend before every read, in microseconds
+
+    static const unsigned long long NEVER = ~0ULL;
+
+    // Charges the time since the library last left the link on entry, and restarts it on exit
+    struct LibraryTime {
+        ReplayLink& link;
+        LibraryTime(ReplayLink& link) : link(link) { link.charge(); }
+        ~LibraryTime() { link.leave(); }
+    };
+
+    void charge() {
+        if (!profile) return;
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        cpuNanos += std::chrono::duration<double, std::nano>(now - lastLeft).count() * cpuScale;
+        unsigned long long elapsed = (unsigned long long)(cpuNanos / 1000);
+        hostMicros += elapsed;
+        cpuNanos -= elapsed * 1000.0;
+    }
+
+    void leave() {
+        lastLeft = std::chrono::steady_clock::now();
+    }
+
+    static void spend(unsigned long us) {
+        if (us == 0) return;
+        std::chrono::steady_clock::time_point until = std::chrono::steady_clock::now() + std::chrono::microseconds(us);
+        while (std::chrono::steady_clock::now() < until) {}
+    }
+
+    // Replies to commands that have not been replayed yet cannot arrive
+    unsigned long long dueTime(const Record& record) {
+        if (record.command < 0) return record.time;
+        if (record.command > current) return NEVER;
+        return record.time + offsets[record.command];
+    }
+
+    bool due() {
+        return rxCursor < records.size() && dueTime(records[rxCursor]) <= hostMicros;
+    }
+
+    // TX records are consumed by write(), so the RX cursor steps over them
+    void skipTX() {
+        while (rxCursor < records.size() && records[rxCursor].tx) rxCursor++;
+    }
+
+    void account(uint8_t c) {
+        if (txCursor == 0) {
+            profile->flushedBytes++;
+            return;
+        }
+        if (profile->rxBytes == 0) profile->firstRx = hostMicros;
+        profile->rxBytes++;
+        if (!flowControlled) return;
+        if (c == FLOWCTRL_XON) framed = true;
+        else if (c == FLOWCTRL_XOFF) framed = false;
+        else if (!framed) profile->unframedBytes++;
+    }
+
+    static const uint8_t FLOWCTRL_XON = 0x11;
+    static const uint8_t FLOWCTRL_XOFF = 0x13;
+};
+
+/******************************************************************************
+ * Trace loading                                                              *
+ *****************************************************************************/
+
+static bool loadTrace(const char* path, std::vector<Record>& records) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        perror(path);
+        return false;
+    }
+    std::vector<uint8_t> raw;
+    uint8_t chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0) raw.insert(raw.end(), chunk, chunk + n);
+    fclose(file);
+
+    // Traces captured over a serial port may carry boot noise in front of the header
+    const size_t magicLength = sizeof(TRACE_MAGIC) - 1;
+    size_t pos = 0;
+    while (pos + magicLength < raw.size() && memcmp(&raw[pos], TRACE_MAGIC, magicLength) != 0) pos++;
+    if (pos + magicLength >= raw.size()) {
+        fprintf(stderr, "%s: no trace header found\n", path);
+        return false;
+    }
+    pos += magicLength;
+    if (raw[pos] != TRACE_VERSION) {
+        fprintf(stderr, "%s: unsupported trace version %u\n", path, raw[pos]);
+        return false;
+    }
+    pos++;
+
+    unsigned long long now = 0;
+    while (pos < raw.size()) {
+        uint8_t tag = raw[pos++];
+        unsigned long long delta = tag & 0x3F;
+        unsigned shift = 6;
+        bool more = tag & TRACE_MORE;
+        while (more && pos < raw.size()) {
+            uint8_t group = raw[pos++];
+            delta |= (unsigned long long)(group & 0x7F) << shift;
+            shift += 7;
+            more = group & 0x80;
+        }
+        if (more || pos >= raw.size()) {
+            fprintf(stderr, "%s: trace truncated after %zu records\n", path, records.size());
+            break;
+        }
+        now += delta;
+        Record record = { now, (tag & TRACE_TX) != 0, raw[pos++], -1 };
+        records.push_back(record);
+    }
+    return true;
+}
+
+static std::vector<Command> splitCommands(std::vector<Record>& records) {
+    std::vector<Command> commands;
+    Command current;
+    long started = -1;
+    for (size_t i = 0; i < records.size(); i++) {
+        if (records[i].tx && current.txRecords.empty()) started++;
+        records[i].command = started;
+        if (!records[i].tx) continue;
+        current.txRecords.push_back(i);
+        current.text += (char)records[i].data;
+        size_t length = current.text.size();
+        if (length >= 2 && current.text.compare(length - 2, 2, "\r\n") == 0) {
+            current.text.erase(length - 2);
+            commands.push_back(current);
+            current = Command();
+        }
+    }
+    if (!current.txRecords.empty()) commands.push_back(current);
+    return commands;
+}
+
+/******************************************************************************
+ * Dispatching commands to the library                                        *
+ *****************************************************************************/
+
+static std::vector<std::string> splitArguments(const std::string& text) {
+    std::vector<std::string> arguments;
+    if (text.size() <= 4) return arguments;
+    size_t begin = 4;
+    while (true) {
+        size_t end = text.find('\x1f', begin);
+        arguments.push_back(text.substr(begin, end == std::string::npos ? std::string::npos : end - begin));
+        if (end == std::string::npos) break;
+        begin = end + 1;
+    }
+    return arguments;
+}
+
+static std::string quote(const String& value) {
+    std::string quoted = "\"";
+    for (unsigned int i = 0; i < value.length() && i < 24; i++) {
+        char c = value.charAt(i);
+        if (c >= 0x20 && c < 0x7F) quoted += c;
+        else {
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\x%02x", (unsigned char)c);
+            quoted += escaped;
+        }
+    }
+    if (value.length() > 24) quoted += "...";
+    return quoted + "\"";
+}
+
+static std::string truth(bool value) {
+    return value ? "true" : "false";
+}
+
+static std::string status(Status value) {
+    switch (value) {
+    case UNRESPONSIVE: return "UNRESPONSIVE";
+    case SUCCESSFUL: return "SUCCESSFUL";
+    case UNSUCCESSFUL: return "UNSUCCESSFUL";
+    case IN_PROGRESS: return "IN_PROGRESS";
+    case NOT_ATTEMPTED: return "NOT_ATTEMPTED";
+    }
+    return "?";
+}
+
+static std::string number(long value) {
+    char buf[24];
+    snprintf(buf, sizeof(buf), "%ld", value);
+    return buf;
+}
+
+static std::string argument(const std::vector<std::string>& arguments, size_t index) {
+    return index < arguments.size() ? arguments[index] : std::string();
+}
+
+static bool isFlowControlled(const std::string& opcode) {
+    return opcode == "ghr" || opcode == "mgs";
+}
+
+/*!
+ * @brief Calls the public function that would have sent this command line
+ *
+ * @return false if the command is not known
+ */
+static bool dispatch(SSTuino& wifi, const Command& command, CallProfile& profile) {
+    std::string opcode = command.text.substr(0, 3);
+    std::vector<std::string> arguments = splitArguments(command.text);
+    String a0 = argument(arguments, 0).c_str();
+    String a1 = argument(arguments, 1).c_str();
+    String a2 = argument(arguments, 2).c_str();
+    int handle = a0.toInt();
+
+    if (opcode == "nop") {
+        profile.name = "smokeTest";
+        profile.result = truth(wifi.smokeTest());
+    } else if (opcode == "ver") {
+        profile.name = "verifyVersion";
+        profile.result = truth(wifi.verifyVersion());
+    } else if (opcode == "rst") {
+        profile.name = "reset";
+        wifi.reset();
+    } else if (opcode == "lap") {
+        profile.name = "getWifiHotspots";
+        profile.result = quote(wifi.getWifiHotspots());
+    } else if (opcode == "cap") {
+        profile.name = "connectToWifi";
+        wifi.connectToWifi(a0, a1);
+    } else if (opcode == "sap") {
+        profile.name = "getWifiStatus";
+        profile.result = status(wifi.getWifiStatus());
+    } else if (opcode == "dap") {
+        profile.name = "disconnectWifi";
+        wifi.disconnectWifi();
+    } else if (opcode == "gip") {
+        profile.name = "getIP";
+        profile.result = quote(wifi.getIP());
+    } else if (opcode == "ihr") {
+        profile.name = "setupHTTP";
+        profile.result = number(wifi.setupHTTP((HTTP_Operation)a0.charAt(0), a1));
+    } else if (opcode == "phr") {
+        profile.name = "setHTTPPOSTParameters";
+        profile.result = truth(wifi.setHTTPPOSTParameters(handle, a1));
+    } else if (opcode == "hhr") {
+        profile.name = "setHTTPHeaders";
+        profile.result = truth(wifi.setHTTPHeaders(handle, a1));
+    } else if (opcode == "thr") {
+        profile.name = "transmitHTTP";
+        profile.result = truth(wifi.transmitHTTP(handle));
+    } else if (opcode == "shr") {
+        profile.name = "getHTTPProgress";
+        profile.result = status(wifi.getHTTPProgress(handle));
+    } else if (opcode == "ghr" && a1.equals("S")) {
+        profile.name = "getHTTPStatusCode";
+        profile.result = number(wifi.getHTTPStatusCode(handle));
+    } else if (opcode == "ghr") {
+        profile.name = "getHTTPReply";
+        HTTP_Content field = a1.equals("H") ? HEADERS : CONTENT;
+        profile.result = quote(wifi.getHTTPReply(handle, field, a2.equals("T")));
+    } else if (opcode == "dhr") {
+        profile.name = "deleteHTTPReply";
+        profile.result = truth(wifi.deleteHTTPReply(handle));
+    } else if (opcode == "mcg" && a0.equals("F")) {
+        profile.name = "disableMQTT";
+        profile.result = truth(wifi.disableMQTT());
+    } else if (opcode == "mcg" && arguments.size() > 3) {
+        profile.name = "enableMQTT";
+        String username = argument(arguments, 3).c_str();
+        String password = argument(arguments, 4).c_str();
+        profile.result = truth(wifi.enableMQTT(a1, a2.equals("T"), username, password));
+    } else if (opcode == "mcg") {
+        profile.name = "enableMQTT";
+        profile.result = truth(wifi.enableMQTT(a1, a2.equals("T")));
+    } else if (opcode == "mic") {
+        profile.name = "isMQTTConnected";
+        profile.result = truth(wifi.isMQTTConnected());
+    } else if (opcode == "mpb") {
+        profile.name = "mqttPublish";
+        profile.result = truth(wifi.mqttPublish(a0, a1));
+    } else if (opcode == "msb") {
+        profile.name = "mqttSubscribe";
+        profile.result = truth(wifi.mqttSubscribe(a0));
+    } else if (opcode == "mus") {
+        profile.name = "mqttUnsubscribe";
+        profile.result = truth(wifi.mqttUnsubscribe(a0));
+    } else if (opcode == "mnd") {
+        profile.name = "mqttNewDataArrived";
+        profile.result = truth(wifi.mqttNewDataArrived(a0));
+    } else if (opcode == "mgs") {
+        profile.name = "mqttGetSubcriptionData";
+        profile.result = quote(wifi.mqttGetSubcriptionData(a0));
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/******************************************************************************
+ * Report                                                                     *
+ *****************************************************************************/
+
+static double ms(unsigned long long us) {
+    return us / 1000.0;
+}
+
+static void printTimeline(const std::vector<CallProfile>& calls, bool csv) {
+    if (csv) {
+        printf("start_ms,call,idle_ms,wait_ms,receive_ms,total_ms,rx_bytes,flushed_bytes,unframed_bytes,diverged,result\n");
+    } else {
+        printf("%10s  %-24s %9s %9s %9s %9s %6s %7s %8s  %s\n", "start(ms)", "call", "idle", "wait",
+               "receive", "total", "rx", "flushed", "unframed", "result");
+    }
+    unsigned long long previousEnd = 0;
+    for (size_t i = 0; i < calls.size(); i++) {
+        const CallProfile& call = calls[i];
+        unsigned long long idle = call.start > previousEnd ? call.start - previousEnd : 0;
+        unsigned long long responded = call.rxBytes ? call.firstRx : call.end;
+        unsigned long long wait = responded - call.txEnd;
+        unsigned long long receive = call.end - responded;
+        unsigned long long total = call.end - call.start;
+        std::string result = call.diverged ? call.result + " [diverged]" : call.result;
+        if (csv) {
+            printf("%.3f,%s,%.3f,%.3f,%.3f,%.3f,%lu,%lu,%lu,%d,%s\n", ms(call.start), call.name.c_str(),
+                   ms(idle), ms(wait), ms(receive), ms(total), call.rxBytes, call.flushedBytes,
+                   call.unframedBytes, call.diverged ? 1 : 0, call.result.c_str());
+        } else {
+            printf("%10.3f  %-24s %9.3f %9.3f %9.3f %9.3f %6lu %7lu %8lu  %s\n", ms(call.start),
+                   call.name.c_str(), ms(idle), ms(wait), ms(receive), ms(total), call.rxBytes,
+                   call.flushedBytes, call.unframedBytes, result.c_str());
+        }
+        previousEnd = call.end;
+    }
+}
+
+static unsigned long long receiveTime(const std::vector<CallProfile>& calls) {
+    unsigned long long receive = 0;
+    for (size_t i = 0; i < calls.size(); i++) {
+        unsigned long long responded = calls[i].rxBytes ? calls[i].firstRx : calls[i].end;
+        receive += calls[i].end - responded;
+    }
+    return receive;
+}
+
+static void printSummary(const std::vector<CallProfile>& calls, size_t skipped, unsigned long leftover) {
+    unsigned long long idle = 0, wait = 0, receive = 0, previousEnd = 0;
+    unsigned long rx = 0, flushed = 0, unframed = 0, diverged = 0;
+    for (size_t i = 0; i < calls.size(); i++) {
+        const CallProfile& call = calls[i];
+        unsigned long long responded = call.rxBytes ? call.firstRx : call.end;
+        if (call.start > previousEnd) idle += call.start - previousEnd;
+        wait += responded - call.txEnd;
+        receive += call.end - responded;
+        rx += call.rxBytes;
+        flushed += call.flushedBytes;
+        unframed += call.unframedBytes;
+        if (call.diverged) diverged++;
+        previousEnd = call.end;
+    }
+    printf("\nSummary\n");
+    printf("  calls replayed             %zu (%zu unknown commands skipped)\n", calls.size(), skipped);
+    printf("  sketch time between calls  %12.3f ms\n", ms(idle));
+    printf("  waiting for the module     %12.3f ms\n", ms(wait));
+    printf("  receiving and scanning     %12.3f ms\n", ms(receive));
+    printf("  bytes read                 %8lu\n", rx);
+    printf("  stale bytes flushed        %8lu\n", flushed);
+    printf("  bytes outside XON/XOFF     %8lu\n", unframed);
+    printf("  bytes never read           %8lu\n", leftover);
+    printf("  diverged calls             %8lu\n", diverged);
+}
+
+/******************************************************************************
+ * Main                                                                       *
+ *****************************************************************************/
+
+int main(int argc, char** argv) {
+    bool csv = false;
+    double maxReceive = -1;
+    double cpuScale = 1;
+    unsigned long readCost = 0;
+    const char* path = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--csv") == 0) csv = true;
+        else if (strcmp(argv[i], "--cpu-scale") == 0 && i + 1 < argc) cpuScale = atof(argv[++i]);
+        else if (strcmp(argv[i], "--max-receive-ms") == 0 && i + 1 < argc) maxReceive = atof(argv[++i]);
+        else if (strcmp(argv[i], "--slow-read-us") == 0 && i + 1 < argc) readCost = strtoul(argv[++i], NULL, 10);
+        else path = argv[i];
+    }
+    if (path == NULL) {
+        fprintf(stderr, "usage: %s [--csv] [--cpu-scale n] [--max-receive-ms ms] [--slow-read-us us] trace.bin\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<Record> records;
+    if (!loadTrace(path, records)) return 1;
+    std::vector<Command> commands = splitCommands(records);
+
+    ReplayLink link(records, commands.size(), cpuScale, readCost);
+    hostLink = &link;
+    hostMicros = 0;
+
+    SSTuino wifi;
+    wifi.openLink();
+
+    std::vector<CallProfile> calls;
+    size_t skipped = 0;
+    bool diverged = false;
+    for (size_t i = 0; i < commands.size(); i++) {
+        const Command& command = commands[i];
+        unsigned long long recordedStart = records[command.txRecords.front()].time;
+        if (recordedStart > hostMicros) hostMicros = recordedStart;
+
+        CallProfile profile = CallProfile();
+        profile.start = profile.txEnd = profile.end = hostMicros;
+        link.beginCall(i, command, &profile, isFlowControlled(command.text.substr(0, 3)));
+        bool known = dispatch(wifi, command, profile);
+        link.endCall();
+        profile.end = hostMicros;
+
+        if (!known) {
+            skipped++;
+            continue;
+        }
+        if (profile.diverged) diverged = true;
+        calls.push_back(profile);
+    }
+    hostLink = NULL;
+
+    printTimeline(calls, csv);
+    if (!csv) printSummary(calls, skipped, link.pendingRX());
+    if (diverged) return 2;
+    if (maxReceive >= 0 && ms(receiveTime(calls)) > maxReceive) {
+        fprintf(stderr, "%s: %.3f ms spent receiving, over the budget of %.3f ms\n", path,
+                ms(receiveTime(calls)), maxReceive);
+        return 3;
+    }
+    return 0;
+}
@@ -142,6 +142,25 @@ void SSTuino::reset() {
     delay(750);
 }
 
+/* ------------------------- Diagnostic  functions ------------------------- */
+
+/*!
+ * @brief Starts recording all traffic to and from the module as a binary trace,
+ * which can be replayed on a computer with the tool in extras/host
+ *
+ * @param sink Where the trace is written to. This should not be shared with other output.
+ */
+void SSTuino::beginTrace(Print& sink) {
+    _ESP01UART.startTrace(sink);
+}
+
+/*!
+ * @brief Stops recording the trace started by beginTrace
+ */
+void SSTuino::endTrace() {
+    _ESP01UART.stopTrace();
+}
+
 /* ---------------------------- Wi-Fi functions ---------------------------- */
 
 String SSTuino::getWifiHotspots() {
@@ -188,24 +207,41 @@ String SSTuino::getIP() {
 /* ---------------------------- HTTP operations ---------------------------- */
 
 int SSTuino::setupHTTP(HTTP_Operation op, const String& url) {
-    rx_empty();
-    writeCommandFromPROGMEM(INITHTTP);
-    _ESP01UART.print((char)op);
-    _ESP01UART.print(DELIMITER);
-    _ESP01UART.print(url);
-    _ESP01UART.print(NEWLINE);
-    String data = recvString(NEWLINE, 1000, 8);
-    if (data.charAt(0) == 'U') return -1; // -1 indicates that the function failed
-    //TODO: can consider performing robust validation for whether it is an integer
-    return data.toInt();
+    beginSetupHTTP(op).print(url);
+    return endSetupHTTP();
+}
+
+int SSTuino::setupHTTP(HTTP_Operation op, const __FlashStringHelper* url) {
+    beginSetupHTTP(op).print(url);
+    return endSetupHTTP();
 }
 
 bool SSTuino::setHTTPPOSTParameters(int handle, const String& data) {
+    beginHTTPPOSTParameters(handle).print(data);
+    return endHTTPPOSTParameters();
+}
+
+/*!
+ * @brief Starts setting the POST parameters, which are then printed straight to the
+ * Wi-Fi chip without building a String. Must be followed by endHTTPPOSTParameters.
+ *
+ * @param handle The handle returned by setupHTTP
+ * @return The stream to print the POST parameters to, for example with a PayloadWriter
+ */
+Print& SSTuino::beginHTTPPOSTParameters(int handle) {
     rx_empty();
     writeCommandFromPROGMEM(POSTPARAMSHTTP);
     _ESP01UART.print(handle);
     _ESP01UART.print(DELIMITER);
-    _ESP01UART.print(data);
+    return _ESP01UART;
+}
+
+/*!
+ * @brief Finishes the POST parameters started by beginHTTPPOSTParameters
+ *
+ * @return true if the Wi-Fi chip accepted the parameters
+ */
+bool SSTuino::endHTTPPOSTParameters() {
     _ESP01UART.print(NEWLINE);
     int16_t result = wait(SUSHORTLONG, 1000);
     if (result == 0) return true;
@@ -213,11 +249,36 @@ bool SSTuino::setHTTPPOSTParameters(int handle, const String& data) {
 }
 
 bool SSTuino::setHTTPHeaders(int handle, const String& data) {
+    beginHTTPHeaders(handle).print(data);
+    return endHTTPHeaders();
+}
+
+bool SSTuino::setHTTPHeaders(int handle, const __FlashStringHelper* data) {
+    beginHTTPHeaders(handle).print(data);
+    return endHTTPHeaders();
+}
+
+/*!
+ * @brief Starts setting the headers, which are then printed straight to the
+ * Wi-Fi chip without building a String. Must be followed by endHTTPHeaders.
+ *
+ * @param handle The handle returned by setupHTTP
+ * @return The stream to print the headers to
+ */
+Print& SSTuino::beginHTTPHeaders(int handle) {
     rx_empty();
     writeCommandFromPROGMEM(HEADERSHTTP);
     _ESP01UART.print(handle);
     _ESP01UART.print(DELIMITER);
-    _ESP01UART.print(data);
+    return _ESP01UART;
+}
+
+/*!
+ * @brief Finishes the headers started by beginHTTPHeaders
+ *
+ * @return true if the Wi-Fi chip accepted the headers
+ */
+bool SSTuino::endHTTPHeaders() {
     _ESP01UART.print(NEWLINE);
     int16_t result = wait(SUSHORTLONG, 1000);
     if (result == 0) return true;
@@ -338,11 +399,109 @@ bool SSTuino::isMQTTConnected() {
 }
 
 bool SSTuino::mqttPublish(const String& topic, const String& content) {
+    mqttBeginPublish(topic).print(content);
+    return mqttEndPublish();
+}
+
+// Typed overloads print the value straight after the topic, without a temporary String
+
+bool SSTuino::mqttPublish(const String& topic, int value) {
+    mqttBeginPublish(topic).print(value);
+    return mqttEndPublish();
+}
+
+bool SSTuino::mqttPublish(const String& topic, unsigned int value) {
+    mqttBeginPublish(topic).print(value);
+    return mqttEndPublish();
+}
+
+bool SSTuino::mqttPublish(const String& topic, long value) {
+    mqttBeginPublish(topic).print(value);
+    return mqttEndPublish();
+}
+
+bool SSTuino::mqttPublish(const String& topic, unsigned long value) {
+    mqttBeginPublish(topic).print(value);
+    return mqttEndPublish();
+}
+
+bool SSTuino::mqttPublish(const String& topic, double value, uint8_t digits /* =2 */) {
+    mqttBeginPublish(topic).print(value, digits);
+    return mqttEndPublish();
+}
+
+/*!
+ * @brief Publishes a fixed-point number, such as a sensor reading kept in hundredths
+ *
+ * @param topic The topic to publish to
+ * @param value The number scaled by 10^decimals, so 2315 with 2 decimals publishes 23.15
+ * @param decimals The number of digits after the decimal point, up to 9
+ * @return true if the Wi-Fi chip accepted the message
+ */
+bool SSTuino::mqttPublishFixed(const String& topic, long value, uint8_t decimals) {
+    PayloadWriter::printFixed(mqttBeginPublish(topic), value, decimals);
+    return mqttEndPublish();
+}
+
+bool SSTuino::mqttPublish(const __FlashStringHelper* topic, int value) {
+    mqttBeginPublish(topic).print(value);
+    return mqttEndPublish();
+}
+
+bool SSTuino::mqttPublish(const __FlashStringHelper* topic, unsigned int value) {
+    mqttBeginPublish(topic).print(value);
+    return mqttEndPublish();
+}
+
+bool SSTuino::mqttPublish(const __FlashStringHelper* topic, long value) {
+    mqttBeginPublish(topic).print(value);
+    return mqttEndPublish();
+}
+
+bool SSTuino::mqttPublish(const __FlashStringHelper* topic, unsigned long value) {
+    mqttBeginPublish(topic).print(value);
+    return mqttEndPublish();
+}
+
+bool SSTuino::mqttPublish(const __FlashStringHelper* topic, double value, uint8_t digits /* =2 */) {
+    mqttBeginPublish(topic).print(value, digits);
+    return mqttEndPublish();
+}
+
+bool SSTuino::mqttPublishFixed(const __FlashStringHelper* topic, long value, uint8_t decimals) {
+    PayloadWriter::printFixed(mqttBeginPublish(topic), value, decimals);
+    return mqttEndPublish();
+}
+
+/*!
+ * @brief Starts publishing a message whose content is printed straight to the
+ * Wi-Fi chip without building a String. Must be followed by mqttEndPublish.
+ *
+ * @param topic The topic to publish to
+ * @return The stream to print the message content to, for example with a PayloadWriter
+ */
+Print& SSTuino::mqttBeginPublish(const String& topic) {
+    rx_empty();
+    writeCommandFromPROGMEM(MQTTPUBLISH);
+    _ESP01UART.print(topic);
+    _ESP01UART.print(DELIMITER);
+    return _ESP01UART;
+}
+
+Print& SSTuino::mqttBeginPublish(const __FlashStringHelper* topic) {
     rx_empty();
     writeCommandFromPROGMEM(MQTTPUBLISH);
     _ESP01UART.print(topic);
     _ESP01UART.print(DELIMITER);
-    _ESP01UART.print(content);
+    return _ESP01UART;
+}
+
+/*!
+ * @brief Finishes the message started by mqttBeginPublish
+ *
+ * @return true if the Wi-Fi chip accepted the message
+ */
+bool SSTuino::mqttEndPublish() {
     _ESP01UART.print(DELIMITER);
     _ESP01UART.print('0');
     _ESP01UART.print(DELIMITER);
@@ -408,6 +567,45 @@ void SSTuino::mqttPollNewData(bool *newDataArrived, const String& topic, unsigne
 
 /* --------------------------- Helper  functions --------------------------- */
 
+/*!
+ * @brief Sends the start of a HTTP setup command, up to where the URL goes
+ */
+Print& SSTuino::beginSetupHTTP(HTTP_Operation op) {
+    rx_empty();
+    writeCommandFromPROGMEM(INITHTTP);
+    _ESP01UART.print((char)op);
+    _ESP01UART.print(DELIMITER);
+    return _ESP01UART;
+}
+
+/*!
+ * @brief Finishes a HTTP setup command started by beginSetupHTTP
+ *
+ * @return The handle of the new request, or -1 if it could not be set up
+ */
+int SSTuino::endSetupHTTP() {
+    _ESP01UART.print(NEWLINE);
+    // The reply is a short handle, so it is read into a fixed buffer instead of a String.
+    // The end of the line is tracked separately, as a longer reply does not fit in it.
+    char data[8] = {'\0'};
+    uint8_t length = 0;
+    char last = '\0';
+    bool lineEnded = false;
+    unsigned long start = millis();
+    while (!lineEnded && millis() - start < 1000) {
+        while (_ESP01UART.available() > 0) {
+            char a = _ESP01UART.read();
+            if (a == '\0') continue;
+            if (length < sizeof(data) - 1) data[length++] = a;
+            if (last == '\r' && a == '\n') lineEnded = true;
+            last = a;
+        }
+    }
+    if (data[0] == 'U') return -1; // -1 indicates that the function failed
+    //TODO: can consider performing robust validation for whether it is an integer
+    return atoi(data);
+}
+
 /*!
  * @brief Flushes serial receive buffer to ensure no characters remaining in the buffer
  */
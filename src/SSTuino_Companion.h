@@ -21,6 +21,9 @@
 #endif
 
 #include <SoftwareSerial.h>
+#include "SSTuino_Trace.h"
+#include "SSTuino_Payload.h"
+#include "SSTuino_Telemetry.h"
 
 /*
  * Enumerations and structs
@@ -70,6 +73,10 @@ public:
     bool verifyVersion();
     void reset();
 
+    // Diagnostics
+    void beginTrace(Print& sink);
+    void endTrace();
+
     // Wi-fi functionality
     String getWifiHotspots();
     bool wifiInRange(const String& ssid);
@@ -82,8 +89,14 @@ public:
 
     // HTTP operations
     int setupHTTP(HTTP_Operation op, const String& url);
+    int setupHTTP(HTTP_Operation op, const __FlashStringHelper* url);
     bool setHTTPPOSTParameters(int handle, const String& data);
+    Print& beginHTTPPOSTParameters(int handle);
+    bool endHTTPPOSTParameters();
     bool setHTTPHeaders(int handle, const String& data);
+    bool setHTTPHeaders(int handle, const __FlashStringHelper* data);
+    Print& beginHTTPHeaders(int handle);
+    bool endHTTPHeaders();
     bool transmitHTTP(int handle);
 
     Status getHTTPProgress(int handle);
@@ -98,6 +111,21 @@ public:
     bool disableMQTT();
     bool isMQTTConnected();
     bool mqttPublish(const String& topic, const String& content);
+    bool mqttPublish(const String& topic, int value);
+    bool mqttPublish(const String& topic, unsigned int value);
+    bool mqttPublish(const String& topic, long value);
+    bool mqttPublish(const String& topic, unsigned long value);
+    bool mqttPublish(const String& topic, double value, uint8_t digits=2);
+    bool mqttPublishFixed(const String& topic, long value, uint8_t decimals);
+    bool mqttPublish(const __FlashStringHelper* topic, int value);
+    bool mqttPublish(const __FlashStringHelper* topic, unsigned int value);
+    bool mqttPublish(const __FlashStringHelper* topic, long value);
+    bool mqttPublish(const __FlashStringHelper* topic, unsigned long value);
+    bool mqttPublish(const __FlashStringHelper* topic, double value, uint8_t digits=2);
+    bool mqttPublishFixed(const __FlashStringHelper* topic, long value, uint8_t decimals);
+    Print& mqttBeginPublish(const String& topic);
+    Print& mqttBeginPublish(const __FlashStringHelper* topic);
+    bool mqttEndPublish();
     bool mqttSubscribe(const String& topic);
     bool mqttUnsubscribe(const String& topic);
     bool mqttNewDataArrived(const String& topic);
@@ -113,11 +141,13 @@ public:
 //     int16_t setIP(bool permanent, String ip, String gateway="", String netmask="");
     
 private:
-    SoftwareSerial _ESP01UART;
+    TracedSerial _ESP01UART;
     unsigned long previousMillis;
     void writeCommandFromPROGMEM(const char* text, int buffersize=8);
     int16_t waitNoOutput(char* values, uint16_t timeOut);
     void rx_empty(void);
+    Print& beginSetupHTTP(HTTP_Operation op);
+    int endSetupHTTP();
     bool recvFind(String target, uint32_t timeout, uint8_t reserve=8);
     String controlledRecvString(uint32_t timeout, FLOWCTRL_TYPE flowControlType, uint8_t reserve=8);
     String recvString(String target, uint32_t timeout, uint8_t reserve=8);
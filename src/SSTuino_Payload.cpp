@@ -0,0 +1,65 @@
+/******************************************************************************
+ *                                                                            *
+ * FILE NAME: SSTuino_Payload.cpp                                             *
+ *                                                                            *
+ * PURPOSE: Implements number formatting for the allocation-free payloads     *
+ *                                                                            *
+ * FILE REFERENCES:                                                           *
+ *                                                                            *
+ * Name I/O Description                                                       *
+ * ---- --- -----------                                                       *
+ * none                                                                       *
+ *                                                                            *
+ * EXTERNAL VARIABLES:                                                        *
+ * Source: .h                                                                 *
+ *                                                                            *
+ * Name Type I/O Description                                                  *
+ * ---- ---- --- -----------                                                  *
+ *                                                                            *
+ * EXTERNAL REFERENCES:                                                       *
+ *                                                                            *
+ * Name Description                                                           *
+ * ---- -----------                                                           *
+ *                                                                            *
+ * ABNORMAL TERMINATION CONDITIONS, ERROR AND WARNING MESSAGES: none          *
+ *                                                                            *
+ * ASSUMPTIONS, CONSTRAINTS, RESTRICTIONS: at most 9 decimal places are       *
+ * supported for fixed-point values                                           *
+ *                                                                            *
+ * NOTES: none                                                                *
+ *                                                                            *
+ * REQUIREMENTS/FUNCTIONAL SPECIFICATIONS REFERENCES: N/A                     *
+ *                                                                            *
+ * ALGORITHM (PDL)                                                            *
+ *                                                                            *
+ *****************************************************************************/
+
+#include "SSTuino_Payload.h"
+
+/*!
+ * @brief Prints a fixed-point number without using floating point maths
+ *
+ * @param out The stream to print to
+ * @param value The number scaled by 10^decimals, so 2315 with 2 decimals prints 23.15
+ * @param decimals The number of digits after the decimal point, up to 9
+ * @return The number of characters printed
+ */
+size_t PayloadWriter::printFixed(Print& out, long value, uint8_t decimals) {
+    if (decimals > 9) decimals = 9;
+    size_t n = 0;
+    unsigned long magnitude = value < 0 ? -(unsigned long)value : (unsigned long)value;
+    if (value < 0) n += out.print('-');
+
+    unsigned long scale = 1;
+    for (uint8_t i = 0; i < decimals; i++) scale *= 10;
+    n += out.print(magnitude / scale);
+    if (decimals == 0) return n;
+
+    n += out.print('.');
+    unsigned long fraction = magnitude % scale;
+    for (scale /= 10; scale > 1 && fraction < scale; scale /= 10) {
+        n += out.print('0');                // Leading zeros of the fraction
+    }
+    n += out.print(fraction);
+    return n;
+}
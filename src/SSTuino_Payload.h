@@ -0,0 +1,79 @@
+/******************************************************************************
+ *                                                                            *
+ * NAME: SSTuino_Payload.h                                                    *
+ *                                                                            *
+ * PURPOSE: Writes numeric fields such as "temp=23.5&hum=41" straight into    *
+ *          an output stream without building a String on the heap            *
+ *                                                                            *
+ * GLOBAL VARIABLES:                                                          *
+ *                                                                            *
+ * Variable Type Description                                                  *
+ * -------- ---- -----------                                                  *
+ *                                                                            *
+ *****************************************************************************/
+
+#ifndef __SSTuino_Payload__
+#define __SSTuino_Payload__
+
+#if (ARDUINO >= 100)
+#include "Arduino.h"
+#else
+#include "WProgram.h"
+#endif
+
+/*
+ * Class declaration
+ */
+
+class PayloadWriter {
+public:
+    explicit PayloadWriter(Print& out, char separator='&') : _out(out), _separator(separator), _fields(0) {}
+
+    // Fields are written as key=value, with the separator in between fields
+    template <typename Key> PayloadWriter& field(const Key& key, int value) {
+        beginField(key);
+        _out.print(value);
+        return *this;
+    }
+    template <typename Key> PayloadWriter& field(const Key& key, unsigned int value) {
+        beginField(key);
+        _out.print(value);
+        return *this;
+    }
+    template <typename Key> PayloadWriter& field(const Key& key, long value) {
+        beginField(key);
+        _out.print(value);
+        return *this;
+    }
+    template <typename Key> PayloadWriter& field(const Key& key, unsigned long value) {
+        beginField(key);
+        _out.print(value);
+        return *this;
+    }
+    template <typename Key> PayloadWriter& field(const Key& key, double value, uint8_t digits=2) {
+        beginField(key);
+        _out.print(value, digits);
+        return *this;
+    }
+    template <typename Key> PayloadWriter& fixed(const Key& key, long value, uint8_t decimals) {
+        beginField(key);
+        printFixed(_out, value, decimals);
+        return *this;
+    }
+
+    static size_t printFixed(Print& out, long value, uint8_t decimals);
+
+private:
+    Print& _out;
+    char _separator;
+    uint8_t _fields;
+
+    template <typename Key> void beginField(const Key& key) {
+        if (_fields > 0) _out.print(_separator);
+        _fields++;
+        _out.print(key);
+        _out.print('=');
+    }
+};
+
+#endif  // End of __SSTuino_Payload__ definition check
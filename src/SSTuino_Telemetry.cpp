@@ -0,0 +1,250 @@
+/******************************************************************************
+ *                                                                            *
+ * FILE NAME: SSTuino_Telemetry.cpp                                           *
+ *                                                                            *
+ * PURPOSE: Implements the telemetry aggregator                               *
+ *                                                                            *
+ * FILE REFERENCES:                                                           *
+ *                                                                            *
+ * Name I/O Description                                                       *
+ * ---- --- -----------                                                       *
+ * none                                                                       *
+ *                                                                            *
+ * EXTERNAL VARIABLES:                                                        *
+ * Source: .h                                                                 *
+ *                                                                            *
+ * Name Type I/O Description                                                  *
+ * ---- ---- --- -----------                                                  *
+ *                                                                            *
+ * EXTERNAL REFERENCES:                                                       *
+ *                                                                            *
+ * Name Description                                                           *
+ * ---- -----------                                                           *
+ *                                                                            *
+ * ABNORMAL TERMINATION CONDITIONS, ERROR AND WARNING MESSAGES: none          *
+ *                                                                            *
+ * ASSUMPTIONS, CONSTRAINTS, RESTRICTIONS: the feed table and the arena are   *
+ * supplied by the sketch, so all memory is reserved at compile time          *
+ *                                                                            *
+ * NOTES: a window is cleared after every send attempt, successful or not,   *
+ * so that memory and link use stay bounded when the network is down          *
+ *                                                                            *
+ * REQUIREMENTS/FUNCTIONAL SPECIFICATIONS REFERENCES: N/A                     *
+ *                                                                            *
+ * ALGORITHM (PDL)                                                            *
+ *                                                                            *
+ *****************************************************************************/
+
+#include "SSTuino_Companion.h"
+
+/******************************************************************************
+ * Constructor                                                                *
+ *****************************************************************************/
+
+/*!
+ * @brief Creates an aggregator that sends its windows through a SSTuino
+ *
+ * @param wifi The SSTuino to send through, which must already be set up
+ * @param feeds A table of at least maxFeeds entries, usually a global array
+ * @param maxFeeds The number of entries in the feed table
+ * @param arena Storage for the samples of raw mode feeds, usually a global array
+ * @param arenaSize The number of samples that fit in the arena
+ */
+Telemetry::Telemetry(SSTuino& wifi, TelemetryFeed* feeds, uint8_t maxFeeds, float* arena, uint16_t arenaSize)
+    : _wifi(wifi), _feeds(feeds), _maxFeeds(maxFeeds), _feedCount(0),
+      _arena(arena), _arenaSize(arenaSize), _arenaUsed(0) {
+}
+
+/******************************************************************************
+ * Public functions                                                           *
+ *****************************************************************************/
+
+/* ------------------------------ Feed  setup ------------------------------ */
+
+/*!
+ * @brief Adds a feed whose windows are published over MQTT
+ *
+ * @param topic The topic to publish to
+ * @param mode Whether to send a summary of the window, its mean or every sample
+ * @param windowSize The number of samples after which the window is sent
+ * @param interval If not 0, the window is also sent every interval milliseconds by poll
+ * @return The feed number to pass to add, or -1 if the feed table or the arena is full
+ */
+int8_t Telemetry::addMQTTFeed(const __FlashStringHelper* topic, TELEMETRY_MODE mode, uint16_t windowSize,
+                              unsigned long interval /* =0 */) {
+    return addFeed(TELEMETRY_MQTT, topic, NULL, mode, windowSize, interval);
+}
+
+/*!
+ * @brief Adds a feed whose windows are sent as HTTP POST parameters
+ *
+ * @param url The URL to POST to
+ * @param headers The HTTP headers to send, or NULL for none
+ * @param mode Whether to send a summary of the window, its mean or every sample
+ * @param windowSize The number of samples after which the window is sent
+ * @param interval If not 0, the window is also sent every interval milliseconds by poll
+ * @return The feed number to pass to add, or -1 if the feed table or the arena is full
+ */
+int8_t Telemetry::addHTTPFeed(const __FlashStringHelper* url, const __FlashStringHelper* headers,
+                              TELEMETRY_MODE mode, uint16_t windowSize, unsigned long interval /* =0 */) {
+    return addFeed(TELEMETRY_HTTP, url, headers, mode, windowSize, interval);
+}
+
+/*!
+ * @brief Sets the number of decimal places sent for a feed. Defaults to 2.
+ */
+void Telemetry::setDigits(int8_t feed, uint8_t digits) {
+    if (feed < 0 || feed >= _feedCount) return;
+    _feeds[feed].digits = digits;
+}
+
+/* ------------------------- Sampling  and sending ------------------------- */
+
+/*!
+ * @brief Adds a sample to a feed, and sends the window once it is full
+ *
+ * @param feed The feed number returned when the feed was added
+ * @param value The sample
+ * @return false if the feed does not exist or sending a full window failed
+ */
+bool Telemetry::add(int8_t feed, float value) {
+    if (feed < 0 || feed >= _feedCount) return false;
+    TelemetryFeed& f = _feeds[feed];
+
+    if (f.mode == TELEMETRY_RAW) {
+        f.samples[f.count] = value;
+    } else {
+        if (f.count == 0 || value < f.minimum) f.minimum = value;
+        if (f.count == 0 || value > f.maximum) f.maximum = value;
+        f.sum += value;
+    }
+    f.last = value;
+    f.count++;
+
+    if (f.count >= f.windowSize) return flush(feed);
+    return true;
+}
+
+/*!
+ * @brief Sends the windows of feeds whose interval has elapsed. Call this from loop.
+ */
+void Telemetry::poll() {
+    unsigned long currentMillis = millis();
+    for (uint8_t i = 0; i < _feedCount; i++) {
+        TelemetryFeed& f = _feeds[i];
+        if (f.interval == 0 || currentMillis - f.lastFlush < f.interval) continue;
+        if (f.count > 0) flush(i);
+        else f.lastFlush = currentMillis;
+    }
+}
+
+/*!
+ * @brief Sends the window of a feed now, if it holds any samples, and starts a new one
+ *
+ * @param feed The feed number returned when the feed was added
+ * @return false if the feed does not exist or the window could not be sent
+ */
+bool Telemetry::flush(int8_t feed) {
+    if (feed < 0 || feed >= _feedCount) return false;
+    TelemetryFeed& f = _feeds[feed];
+    if (f.count == 0) return true;
+    bool result = send(f);
+    resetWindow(f);
+    f.lastFlush = millis();
+    return result;
+}
+
+/*!
+ * @brief Sends the windows of all feeds now
+ */
+void Telemetry::flushAll() {
+    for (uint8_t i = 0; i < _feedCount; i++) {
+        flush(i);
+    }
+}
+
+/******************************************************************************
+ * Private functions                                                          *
+ *****************************************************************************/
+
+int8_t Telemetry::addFeed(TELEMETRY_SINK sink, const __FlashStringHelper* destination,
+                          const __FlashStringHelper* headers, TELEMETRY_MODE mode, uint16_t windowSize,
+                          unsigned long interval) {
+    if (_feedCount >= _maxFeeds || windowSize == 0) return -1;
+    TelemetryFeed& f = _feeds[_feedCount];
+    f.samples = NULL;
+    if (mode == TELEMETRY_RAW) {
+        if (windowSize > _arenaSize - _arenaUsed) return -1;
+        f.samples = _arena + _arenaUsed;
+        _arenaUsed += windowSize;
+    }
+    f.destination = destination;
+    f.headers = headers;
+    f.sink = sink;
+    f.mode = mode;
+    f.windowSize = windowSize;
+    f.digits = 2;
+    f.httpHandle = -1;
+    f.interval = interval;
+    f.lastFlush = millis();
+    resetWindow(f);
+    return _feedCount++;
+}
+
+/*!
+ * @brief Writes a window as "count=..&min=..&max=..&mean=..&last=.." in summary mode,
+ * as a plain number in mean mode ("value=.." for HTTP feeds, which need a form body),
+ * or as "values=..,..,.." in raw mode
+ */
+void Telemetry::writePayload(const TelemetryFeed& feed, Print& out) {
+    if (feed.mode == TELEMETRY_MEAN && feed.sink == TELEMETRY_HTTP) {
+        PayloadWriter(out).field(F("value"), feed.sum / feed.count, feed.digits);
+        return;
+    }
+    if (feed.mode == TELEMETRY_MEAN) {
+        out.print(feed.sum / feed.count, feed.digits);
+        return;
+    }
+    if (feed.mode == TELEMETRY_RAW) {
+        out.print(F("values="));
+        for (uint16_t i = 0; i < feed.count; i++) {
+            if (i > 0) out.print(',');
+            out.print(feed.samples[i], feed.digits);
+        }
+        return;
+    }
+    PayloadWriter(out)
+        .field(F("count"), (unsigned int)feed.count)
+        .field(F("min"), feed.minimum, feed.digits)
+        .field(F("max"), feed.maximum, feed.digits)
+        .field(F("mean"), feed.sum / feed.count, feed.digits)
+        .field(F("last"), feed.last, feed.digits);
+}
+
+bool Telemetry::send(TelemetryFeed& feed) {
+    if (feed.sink == TELEMETRY_MQTT) {
+        writePayload(feed, _wifi.mqttBeginPublish(feed.destination));
+        return _wifi.mqttEndPublish();
+    }
+
+    // The previous reply is no longer needed, but it can only be freed once the
+    // request has finished. Until it is freed this window is dropped, like any failed send.
+    if (feed.httpHandle != -1) {
+        Status progress = _wifi.getHTTPProgress(feed.httpHandle);
+        if (progress == IN_PROGRESS || progress == UNRESPONSIVE) return false;
+        if (!_wifi.deleteHTTPReply(feed.httpHandle)) return false;
+    }
+    feed.httpHandle = _wifi.setupHTTP(POST, feed.destination);
+    if (feed.httpHandle == -1) return false;
+    writePayload(feed, _wifi.beginHTTPPOSTParameters(feed.httpHandle));
+    if (!_wifi.endHTTPPOSTParameters()) return false;
+    if (feed.headers && !_wifi.setHTTPHeaders(feed.httpHandle, feed.headers)) return false;
+    return _wifi.transmitHTTP(feed.httpHandle);
+}
+
+void Telemetry::resetWindow(TelemetryFeed& feed) {
+    feed.count = 0;
+    feed.minimum = 0;
+    feed.maximum = 0;
+    feed.sum = 0;
+}
@@ -0,0 +1,95 @@
+/******************************************************************************
+ *                                                                            *
+ * NAME: SSTuino_Telemetry.h                                                  *
+ *                                                                            *
+ * PURPOSE: Batches high-rate sensor samples into per-feed windows and sends  *
+ *          each window as a single MQTT or HTTP POST message                 *
+ *                                                                            *
+ * GLOBAL VARIABLES:                                                          *
+ *                                                                            *
+ * Variable Type Description                                                  *
+ * -------- ---- -----------                                                  *
+ *                                                                            *
+ *****************************************************************************/
+
+#ifndef __SSTuino_Telemetry__
+#define __SSTuino_Telemetry__
+
+#if (ARDUINO >= 100)
+#include "Arduino.h"
+#else
+#include "WProgram.h"
+#endif
+
+class SSTuino;
+
+/*
+ * Enumerations and structs
+ */
+
+enum TELEMETRY_MODE {
+    TELEMETRY_SUMMARY,  // Sends count, min, max, mean and last of the window
+    TELEMETRY_MEAN,     // Sends only the mean of the window, as a plain number or value=.. over HTTP
+    TELEMETRY_RAW       // Sends every sample of the window, which uses space in the arena
+};
+
+enum TELEMETRY_SINK {
+    TELEMETRY_MQTT,
+    TELEMETRY_HTTP
+};
+
+struct TelemetryFeed {
+    const __FlashStringHelper* destination;     // MQTT topic or HTTP URL
+    const __FlashStringHelper* headers;         // HTTP headers, may be NULL
+    TELEMETRY_SINK sink;
+    TELEMETRY_MODE mode;
+    float* samples;                             // Slice of the arena, raw mode only
+    uint16_t windowSize;
+    uint16_t count;
+    float minimum;
+    float maximum;
+    float sum;
+    float last;
+    uint8_t digits;
+    int httpHandle;                             // Handle of the last HTTP POST, -1 once freed
+    unsigned long interval;                     // 0 if the feed is only flushed when full
+    unsigned long lastFlush;
+};
+
+/*
+ * Class declaration
+ */
+
+class Telemetry {
+public:
+    Telemetry(SSTuino& wifi, TelemetryFeed* feeds, uint8_t maxFeeds, float* arena, uint16_t arenaSize);
+
+    // Feed setup
+    int8_t addMQTTFeed(const __FlashStringHelper* topic, TELEMETRY_MODE mode, uint16_t windowSize,
+                       unsigned long interval=0);
+    int8_t addHTTPFeed(const __FlashStringHelper* url, const __FlashStringHelper* headers, TELEMETRY_MODE mode,
+                       uint16_t windowSize, unsigned long interval=0);
+    void setDigits(int8_t feed, uint8_t digits);
+
+    // Sampling and sending
+    bool add(int8_t feed, float value);
+    void poll();
+    bool flush(int8_t feed);
+    void flushAll();
+
+private:
+    SSTuino& _wifi;
+    TelemetryFeed* _feeds;
+    uint8_t _maxFeeds;
+    uint8_t _feedCount;
+    float* _arena;
+    uint16_t _arenaSize;
+    uint16_t _arenaUsed;
+    int8_t addFeed(TELEMETRY_SINK sink, const __FlashStringHelper* destination, const __FlashStringHelper* headers,
+                   TELEMETRY_MODE mode, uint16_t windowSize, unsigned long interval);
+    void writePayload(const TelemetryFeed& feed, Print& out);
+    bool send(TelemetryFeed& feed);
+    void resetWindow(TelemetryFeed& feed);
+};
+
+#endif  // End of __SSTuino_Telemetry__ definition check
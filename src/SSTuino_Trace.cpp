@@ -0,0 +1,128 @@
+/******************************************************************************
+ *                                                                            *
+ * FILE NAME: SSTuino_Trace.cpp                                               *
+ *                                                                            *
+ * PURPOSE: Implements the traced serial transport to the ESP-01 module       *
+ *                                                                            *
+ * FILE REFERENCES:                                                           *
+ *                                                                            *
+ * Name I/O Description                                                       *
+ * ---- --- -----------                                                       *
+ * none                                                                       *
+ *                                                                            *
+ * EXTERNAL VARIABLES:                                                        *
+ * Source: .h                                                                 *
+ *                                                                            *
+ * Name Type I/O Description                                                  *
+ * ---- ---- --- -----------                                                  *
+ *                                                                            *
+ * EXTERNAL REFERENCES:                                                       *
+ *                                                                            *
+ * Name Description                                                           *
+ * ---- -----------                                                           *
+ *                                                                            *
+ * ABNORMAL TERMINATION CONDITIONS, ERROR AND WARNING MESSAGES: none          *
+ *                                                                            *
+ * ASSUMPTIONS, CONSTRAINTS, RESTRICTIONS: the trace sink must keep up with   *
+ * the link, as records are written synchronously                             *
+ *                                                                            *
+ * NOTES: RX bytes are timestamped when the library reads them, not when     *
+ * they arrive on the wire                                                    *
+ *                                                                            *
+ * REQUIREMENTS/FUNCTIONAL SPECIFICATIONS REFERENCES: N/A                     *
+ *                                                                            *
+ * ALGORITHM (PDL)                                                            *
+ *                                                                            *
+ *****************************************************************************/
+
+#include "SSTuino_Trace.h"
+
+/******************************************************************************
+ * Constructor                                                                *
+ *****************************************************************************/
+
+TracedSerial::TracedSerial(uint8_t receivePin, uint8_t transmitPin)
+    : _serial(receivePin, transmitPin), _traceSink(NULL), _lastTraceMicros(0) {
+}
+
+void TracedSerial::begin(long speed) {
+    _serial.begin(speed);
+}
+
+/******************************************************************************
+ * Tracing                                                                    *
+ *****************************************************************************/
+
+/*!
+ * @brief Starts recording every TX and RX byte into a sink
+ *
+ * @param sink Where the binary trace is written to, such as Serial or an SD card file
+ */
+void TracedSerial::startTrace(Print& sink) {
+    _traceSink = &sink;
+    _traceSink->write((const uint8_t *)TRACE_MAGIC, sizeof(TRACE_MAGIC) - 1);
+    _traceSink->write(TRACE_VERSION);
+    _lastTraceMicros = micros();
+}
+
+/*!
+ * @brief Stops recording, leaving the link untouched
+ */
+void TracedSerial::stopTrace() {
+    _traceSink = NULL;
+}
+
+/******************************************************************************
+ * Stream implementation                                                      *
+ *****************************************************************************/
+
+int TracedSerial::available() {
+    return _serial.available();
+}
+
+int TracedSerial::read() {
+    int c = _serial.read();
+    if (c >= 0 && _traceSink) record(TRACE_RX, (uint8_t)c);
+    return c;
+}
+
+int TracedSerial::peek() {
+    return _serial.peek();
+}
+
+void TracedSerial::flush() {
+    _serial.flush();
+}
+
+size_t TracedSerial::write(uint8_t data) {
+    if (_traceSink) record(TRACE_TX, data);
+    return _serial.write(data);
+}
+
+/******************************************************************************
+ * Private functions                                                          *
+ *****************************************************************************/
+
+/*!
+ * @brief Writes a single trace record to the sink
+ *
+ * @param direction Whether the byte was sent to or received from the module
+ * @param data The byte that crossed the link
+ */
+void TracedSerial::record(TRACE_DIRECTION direction, uint8_t data) {
+    unsigned long now = micros();
+    unsigned long delta = now - _lastTraceMicros;
+    _lastTraceMicros = now;
+
+    uint8_t tag = direction | (delta & 0x3F);
+    delta >>= 6;
+    if (delta) tag |= TRACE_MORE;
+    _traceSink->write(tag);
+    while (delta) {
+        uint8_t group = delta & 0x7F;
+        delta >>= 7;
+        if (delta) group |= 0x80;
+        _traceSink->write(group);
+    }
+    _traceSink->write(data);
+}
@@ -0,0 +1,80 @@
+/******************************************************************************
+ *                                                                            *
+ * NAME: SSTuino_Trace.h                                                      *
+ *                                                                            *
+ * PURPOSE: Serial transport with an optional tap that records every byte     *
+ *          exchanged with the ULWI firmware into a compact binary trace      *
+ *                                                                            *
+ * GLOBAL VARIABLES:                                                          *
+ *                                                                            *
+ * Variable Type Description                                                  *
+ * -------- ---- -----------                                                  *
+ *                                                                            *
+ *****************************************************************************/
+
+#ifndef __SSTuino_Trace__
+#define __SSTuino_Trace__
+
+#if (ARDUINO >= 100)
+#include "Arduino.h"
+#else
+#include "WProgram.h"
+#endif
+
+#include <SoftwareSerial.h>
+
+/*
+ * Trace format
+ *
+ * A trace starts with the magic "SSTT" followed by a single version byte.
+ * Every byte crossing the link is then stored as one record:
+ *
+ *   tag    bit 7    direction (1 = TX to the module, 0 = RX from the module)
+ *          bit 6    set if more delta bytes follow
+ *          bits 0-5 lowest 6 bits of the time since the previous record (us)
+ *   delta  remaining bits of the time delta, 7 bits per byte, lowest first,
+ *          bit 7 set if more delta bytes follow
+ *   data   the byte itself
+ *
+ * At 9600 baud a record is usually 3 bytes long.
+ */
+
+const char TRACE_MAGIC[] = "SSTT";
+const uint8_t TRACE_VERSION = 1;
+
+enum TRACE_DIRECTION {
+    TRACE_RX = 0x00,
+    TRACE_TX = 0x80
+};
+
+const uint8_t TRACE_MORE = 0x40;
+
+/*
+ * Class declaration
+ */
+
+class TracedSerial : public Stream {
+public:
+    TracedSerial(uint8_t receivePin, uint8_t transmitPin);
+    void begin(long speed);
+
+    // Tracing
+    void startTrace(Print& sink);
+    void stopTrace();
+
+    // Stream implementation
+    int available();
+    int read();
+    int peek();
+    void flush();
+    size_t write(uint8_t data);
+    using Print::write;
+
+private:
+    SoftwareSerial _serial;
+    Print* _traceSink;
+    unsigned long _lastTraceMicros;
+    void record(TRACE_DIRECTION direction, uint8_t data);
+};
+
+#endif  // End of __SSTuino_Trace__ definition check